@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorPoolGameInstanceSubsystem.h"
+#include "Engine/GameInstance.h"
+
+UActorPoolGameInstanceSubsystem* UActorPoolGameInstanceSubsystem::GetActorPoolGameInstanceSubsystem(const UObject* WorldContextObject)
+{
+	if(!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = WorldContextObject->GetWorld();
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UActorPoolGameInstanceSubsystem>() : nullptr;
+}
+
+void UActorPoolGameInstanceSubsystem::StorePool(const FActorPoolKey& PoolKey, const FActorPool& ActorPool)
+{
+	// The transition world may hand over a pool we are already holding, combine them instead of keeping two
+	FPersistentActorPool* ExistingPool = PersistentPools.FindByPredicate([&PoolKey](const FPersistentActorPool& PersistentPool)
+	{
+		return PersistentPool.ActorClass == PoolKey.ActorClass && PersistentPool.Variant == PoolKey.Variant;
+	});
+
+	if(ExistingPool)
+	{
+		ExistingPool->ActorPool.Pool.Append(ActorPool.Pool);
+		return;
+	}
+
+	FPersistentActorPool& PersistentPool = PersistentPools.AddDefaulted_GetRef();
+	PersistentPool.ActorClass = PoolKey.ActorClass;
+	PersistentPool.Variant = PoolKey.Variant;
+	PersistentPool.ActorPool = ActorPool;
+}
+
+void UActorPoolGameInstanceSubsystem::AddPersistentActorsToList(TArray<AActor*>& ActorList) const
+{
+	for(const FPersistentActorPool& PersistentPool : PersistentPools)
+	{
+		for(AActor* Actor : PersistentPool.ActorPool.Pool)
+		{
+			// Both the game mode and the player controller add our actors on a listen server
+			if(IsValid(Actor))
+			{
+				ActorList.AddUnique(Actor);
+			}
+		}
+	}
+}
+
+void UActorPoolGameInstanceSubsystem::SetTravellingToDestination(const bool bInTravellingToDestination)
+{
+	bTravellingToDestination = bInTravellingToDestination;
+}
+
+bool UActorPoolGameInstanceSubsystem::HasPoolsToAdopt() const
+{
+	return bTravellingToDestination && !PersistentPools.IsEmpty();
+}
+
+TArray<FPersistentActorPool> UActorPoolGameInstanceSubsystem::TakePersistentPools()
+{
+	bTravellingToDestination = false;
+	return MoveTemp(PersistentPools);
+}
@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorPoolGameModeBase.h"
+#include "ActorPoolWorldSubsystem.h"
+
+void AActorPoolGameModeBase::GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToTransition, ActorList);
+
+	if(UActorPoolWorldSubsystem* ActorPoolWorldSubsystem = UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(this))
+	{
+		ActorPoolWorldSubsystem->AddPersistentPoolsToSeamlessTravelList(bToTransition, ActorList);
+	}
+}
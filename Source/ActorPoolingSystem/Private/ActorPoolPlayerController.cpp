@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorPoolPlayerController.h"
+#include "ActorPoolWorldSubsystem.h"
+
+void AActorPoolPlayerController::GetSeamlessTravelActorList(bool bToEntry, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToEntry, ActorList);
+
+	// Only local player controllers are asked, on a listen server the game mode has already handed our pools over
+	if(UActorPoolWorldSubsystem* ActorPoolWorldSubsystem = UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(this))
+	{
+		ActorPoolWorldSubsystem->AddPersistentPoolsToSeamlessTravelList(bToEntry, ActorList);
+	}
+}
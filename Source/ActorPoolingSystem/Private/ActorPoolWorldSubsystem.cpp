@@ -2,13 +2,66 @@
 
 
 #include "ActorPoolWorldSubsystem.h"
+#include "ActorPoolGameInstanceSubsystem.h"
 #include "PooledActorInterface.h"
 #include "Core/ActorPoolingDeveloperSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
 
 
 const TSoftObjectPtr<UDataTable> UActorPoolWorldSubsystem::DefaultActorPoolDataTable = 
 	TSoftObjectPtr<UDataTable>(FSoftObjectPath(TEXT("DataTable'/ActorPoolingSystem/DT_DefaultPoolData.DT_DefaultPoolData'")));
 
+static FAutoConsoleCommand MergePoolUsageProfilesCommand(
+	TEXT("ActorPool.MergeUsageProfiles"),
+	TEXT("Merges all recorded pool usage sessions for a map into the profiles used for prewarming, one per net mode. Usage: ActorPool.MergeUsageProfiles <MapName> [NetMode]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if(Args.Num() > 0)
+		{
+			UActorPoolWorldSubsystem::MergePoolUsageProfiles(Args[0], Args.Num() > 1 ? Args[1] : FString());
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs MeasureGarbageCollectionCommand(
+	TEXT("ActorPool.MeasureGC"),
+	TEXT("Runs full garbage collections and logs the average time along with the amount of pooled actors. Usage: ActorPool.MeasureGC [Iterations]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if(UActorPoolWorldSubsystem* Subsystem = UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(World))
+		{
+			Subsystem->MeasureGarbageCollectionTime(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkPoolCallbacksCommand(
+	TEXT("ActorPool.BenchmarkCallbacks"),
+	TEXT("Compares the cost per pop of Blueprint event dispatch and native dispatch of pool callbacks. Usage: ActorPool.BenchmarkCallbacks <ClassPath> [Iterations]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UActorPoolWorldSubsystem* Subsystem = UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(World);
+		UClass* ActorClass = Args.Num() > 0 ? LoadObject<UClass>(nullptr, *Args[0]) : nullptr;
+		if(Subsystem && ActorClass)
+		{
+			Subsystem->BenchmarkPoolCallbacks(ActorClass, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 10000);
+		}
+	}));
+
+static const TCHAR* GetNetModeName(const ENetMode NetMode)
+{
+	switch(NetMode)
+	{
+	case NM_DedicatedServer:
+		return TEXT("DedicatedServer");
+	case NM_ListenServer:
+		return TEXT("ListenServer");
+	case NM_Client:
+		return TEXT("Client");
+	default:
+		return TEXT("Standalone");
+	}
+}
+
 bool UActorPoolWorldSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 {
 	return true;
@@ -17,13 +70,31 @@ bool UActorPoolWorldSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 void UActorPoolWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	// Only record actual play sessions, editor worlds would overwrite profiles with empty usage
+	const UWorld* World = GetWorld();
+	bRecordingPoolUsage = World && World->IsGameWorld() &&
+		UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->bRecordPoolUsageProfiles;
 }
 
 void UActorPoolWorldSubsystem::Deinitialize()
 {
+	// Merging reads every recorded session of the map, keep that out of world teardown
+	if(bRecordingPoolUsage)
+	{
+		SaveSessionUsageProfile();
+	}
+
 	Super::Deinitialize();
 }
 
+void UActorPoolWorldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	AdoptPersistentPools();
+}
+
 UActorPoolWorldSubsystem* UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(const UObject* WorldContextObject)
 {
 	if(!WorldContextObject)
@@ -37,13 +108,17 @@ UActorPoolWorldSubsystem* UActorPoolWorldSubsystem::GetActorPoolWorldSubsystem(c
 
 void UActorPoolWorldSubsystem::SetupActorPoolDefaults()
 {
+	// Pools that came with us through seamless travel are already filled, adopt them first so we don't create them again
+	AdoptPersistentPools();
+
 	// Get all of our soft object paths associated with our developer settings for default actor pools
 	const TArray<TSoftObjectPtr<UDataTable>>& ActorPoolPaths =
 		UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->DefaultActorPoolPaths;
 
 
 	/* For each path, load the object it is pointing to,
-	 * get all rows that are a default actor pool data and create pools with the found rows */
+	 * get all rows that are a default actor pool data and gather them so they can be adjusted before creating pools */
+	TArray<FDefaultActorPoolData> DefaultPoolData;
 	for(const TSoftObjectPtr<UDataTable>& Path: ActorPoolPaths)
 	{
 		if(const UDataTable* Table = Path.LoadSynchronous())
@@ -55,12 +130,48 @@ void UActorPoolWorldSubsystem::SetupActorPoolDefaults()
 			{
 				if(const FDefaultActorPoolData* Data = PoolData[i])
 				{
-					CreatePool(Data->ActorClass, Data->MinimumPoolSize, Data->MaximumPoolSize, Data->PoolSize);
+					DefaultPoolData.Add(*Data);
 				}
 			}
 		}
 	}
 
+	// Resize and reorder our default pools based on how they were used during previous sessions of this map
+	if(UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->bUsePoolUsageProfiles)
+	{
+		ApplyPoolUsageProfile(DefaultPoolData);
+	}
+
+	// Either create every pool right away or queue them up to be prewarmed a few actors at a time in order
+	const bool bPrewarmOverFrames = UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->PrewarmActorsPerFrame > 0;
+	for(const FDefaultActorPoolData& Data : DefaultPoolData)
+	{
+		if(PoolMap.Contains(FActorPoolKey(Data.ActorClass, Data.PoolVariant)))
+		{
+			continue;
+		}
+
+		// Setting up defaults again while still prewarming shouldn't queue the same pool twice
+		const bool bAlreadyPending = PendingPrewarmData.ContainsByPredicate([&Data](const FDefaultActorPoolData& PendingData)
+		{
+			return PendingData.ActorClass == Data.ActorClass && PendingData.PoolVariant == Data.PoolVariant;
+		});
+
+		if(bAlreadyPending)
+		{
+			continue;
+		}
+
+		if(bPrewarmOverFrames)
+		{
+			PendingPrewarmData.Add(Data);
+		}
+		else
+		{
+			CreateVariantPool(Data.ActorClass, Data.PoolVariant, Data.MinimumPoolSize, Data.MaximumPoolSize, Data.PoolSize);
+		}
+	}
+
 	// Get all of our soft object paths associated with our developer settings for our actor pop settings
 	const TArray<TSoftObjectPtr<UDataTable>>& SettingsPaths =
 		UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->ActorPoolSettingsPaths;
@@ -86,6 +197,17 @@ void UActorPoolWorldSubsystem::SetupActorPoolDefaults()
 			}
 		}
 	}
+
+	// Only start prewarming if we aren't already, otherwise every call would add another frame's worth of budget
+	if(!PendingPrewarmData.IsEmpty() && !GetWorld()->GetTimerManager().IsTimerActive(PrewarmTimerHandle))
+	{
+		PrewarmPendingPools();
+	}
+}
+
+bool UActorPoolWorldSubsystem::IsPrewarmingPools() const
+{
+	return !PendingPrewarmData.IsEmpty();
 }
 
 AActor* UActorPoolWorldSubsystem::RequestActorFromPool(TSubclassOf<AActor> ActorClass, const FActorPopData& PopData)
@@ -95,21 +217,30 @@ AActor* UActorPoolWorldSubsystem::RequestActorFromPool(TSubclassOf<AActor> Actor
 		return nullptr;
 	}
 
-	if(AActor* Actor = PopActorOfType(ActorClass, PopData))
+	// Each variant of a class has its own pool, so actors we hand out are already set up as the requested variant
+	const FActorPoolKey PoolKey(ActorClass, PopData.PoolVariant);
+	RecordPoolRequest(PoolKey);
+
+	if(AActor* Actor = PopActorOfType(PoolKey, PopData))
 	{
+		RecordActorLeftPool(PoolKey, Actor);
 		return Actor;
 	}
 
+	// Having to spawn during play means the pool was too small for the demand, only count it once per request
+	RecordPoolMiss(PoolKey);
+
 	// We might not have had an actor available so force spawn and return one 
-	if(PoolMap.Contains(ActorClass))
+	if(PoolMap.Contains(PoolKey))
 	{
-		AActor* Actor = ForceSpawnActor(ActorClass);
+		AActor* Actor = SpawnPooledActor(PoolKey);
 		OnActorLeftPool(Actor, PopData);
+		RecordActorLeftPool(PoolKey, Actor);
 		return Actor;
 	}
 
 	// Didn't contain a pool for the requested class, create a pool and return an actor of the pool is created
-	CreatePool(ActorClass, DefaultMinimumPoolSize, DefaultPoolSize);
+	CreateVariantPool(ActorClass, PopData.PoolVariant, DefaultMinimumPoolSize, DefaultPoolSize);
 	return RequestActorFromPool(ActorClass, PopData);
 }
 
@@ -128,14 +259,16 @@ bool UActorPoolWorldSubsystem::AddActorToPool(AActor* Actor)
 		return false;
 	}
 
-	if(!PoolMap.Contains(Actor->GetClass()))
+	// Actors go back to the pool of the variant they were set up as
+	const FActorPoolKey PoolKey = GetPoolKey(Actor);
+
+	if(!PoolMap.Contains(PoolKey))
 	{
-		CreatePool(Actor->GetClass(), DefaultMinimumPoolSize, DefaultMaximumPoolSize, DefaultPoolSize);
+		CreateVariantPool(PoolKey.ActorClass, PoolKey.Variant, DefaultMinimumPoolSize, DefaultMaximumPoolSize, DefaultPoolSize);
 	}
 
-	if (const TSharedPtr<FActorPool>* PoolPointer = PoolMap.Find(Actor->GetClass()))
+	if (FActorPool* Pool = PoolMap.Find(PoolKey))
 	{
-		FActorPool* Pool = PoolPointer->Get();
 		// Make sure our actor isn't already contained in the pool
 		if(Pool->ContainsActor(Actor))
 		{
@@ -146,12 +279,15 @@ bool UActorPoolWorldSubsystem::AddActorToPool(AActor* Actor)
 		// Make sure our pool is able to grow before trying to add the actor
 		if(!Pool->CanGrow())
 		{
+			// Destroying the actor already stops counting it as checked out, unless it couldn't be destroyed
 			Actor->Destroy();
+			RecordActorReturnedToPool(Actor);
 			return false;
 		}
 
 		Pool->Push(Actor);
 		OnActorEnteredPool(Actor);
+		RecordActorReturnedToPool(Actor);
 		return true;
 	}
 
@@ -159,6 +295,11 @@ bool UActorPoolWorldSubsystem::AddActorToPool(AActor* Actor)
 }
 
 bool UActorPoolWorldSubsystem::CreatePool(TSubclassOf<AActor> ActorClass, int MinimumPoolSize, int MaximumPoolSize, int Amount)
+{
+	return CreateVariantPool(ActorClass, FActorPoolVariant(), MinimumPoolSize, MaximumPoolSize, Amount);
+}
+
+bool UActorPoolWorldSubsystem::CreateVariantPool(TSubclassOf<AActor> ActorClass, const FActorPoolVariant& Variant, int MinimumPoolSize, int MaximumPoolSize, int Amount)
 {
 	if(!IsValidActorClass(ActorClass))
 	{
@@ -166,7 +307,8 @@ bool UActorPoolWorldSubsystem::CreatePool(TSubclassOf<AActor> ActorClass, int Mi
 		return false;
 	}
 
-	if(PoolMap.Find(ActorClass))
+	const FActorPoolKey PoolKey(ActorClass, Variant);
+	if(PoolMap.Find(PoolKey))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Pool already exists for class, could not create pool."))
 		return false;
@@ -177,10 +319,10 @@ bool UActorPoolWorldSubsystem::CreatePool(TSubclassOf<AActor> ActorClass, int Mi
 	Amount = FMath::Max(MinimumPoolSize, Amount);
 	MaximumPoolSize = FMath::Max(Amount, MaximumPoolSize);
 
-	// Create a shared pointer to a new ActorPool, fill that pool with the specified amount of actors, and add it to our map so we can keep track of its lifetime
-	const TSharedPtr<FActorPool> ActorPool = MakeShared<FActorPool>(MinimumPoolSize, MaximumPoolSize);
-	FillPool(ActorClass, *ActorPool, Amount);
-	PoolMap.Add(ActorClass, ActorPool);
+	// Create a new ActorPool, fill that pool with the specified amount of actors, and add it to our map so we can keep track of its lifetime
+	FActorPool ActorPool(MinimumPoolSize, MaximumPoolSize);
+	FillPool(PoolKey, ActorPool.Pool, Amount);
+	PoolMap.Add(PoolKey, MoveTemp(ActorPool));
 	return true;
 }
 
@@ -192,11 +334,39 @@ bool UActorPoolWorldSubsystem::RemovePool(TSubclassOf<AActor> ActorClass)
 		return false;
 	}
 
-	// Make sure a pool exists for the class
-	if(TSharedPtr<FActorPool>* ActorPool = PoolMap.Find(ActorClass))
+	// Gather the pools of every variant of the class first, destroying actors can run callbacks that change our pools
+	TArray<FActorPoolKey> RemovedPoolKeys;
+	for(const TPair<FActorPoolKey, FActorPool>& Pair : PoolMap)
+	{
+		if(Pair.Key.ActorClass == ActorClass)
+		{
+			RemovedPoolKeys.Add(Pair.Key);
+		}
+	}
+
+	// Move the pools out of our map before releasing them so nothing can find or refill them while their actors are destroyed
+	TArray<FActorPool> RemovedPools;
+	for(const FActorPoolKey& PoolKey : RemovedPoolKeys)
+	{
+		PoolMap.RemoveAndCopyValue(PoolKey, RemovedPools.AddDefaulted_GetRef());
+	}
+
+	for(FActorPool& RemovedPool : RemovedPools)
+	{
+		ReleaseFromPool(RemovedPool, RemovedPool.Num());
+	}
+
+	// Make sure at least one variant of the class had a pool
+	const bool bRemovedPool = !RemovedPools.IsEmpty();
+
+	// Don't let prewarming bring back a pool that was removed
+	PendingPrewarmData.RemoveAll([&ActorClass](const FDefaultActorPoolData& Data)
+	{
+		return Data.ActorClass == ActorClass;
+	});
+
+	if(bRemovedPool)
 	{
-		ReleaseFromPool(*ActorPool->Get(), ActorPool->Get()->Pool.Num());
-		PoolMap.Remove(ActorClass);
 		return true;
 	}
 
@@ -209,21 +379,270 @@ bool UActorPoolWorldSubsystem::ModifyPoolMinimumSize(TSubclassOf<AActor> ActorCl
 	return false;
 }
 
-AActor* UActorPoolWorldSubsystem::PopActorOfType(TSubclassOf<AActor> ActorClass, const FActorPopData& PopData)
+void UActorPoolWorldSubsystem::AddPersistentPoolsToSeamlessTravelList(bool bToTransition, TArray<AActor*>& ActorList)
 {
-	if (TSharedPtr<FActorPool>* PoolPointer = PoolMap.Find(ActorClass))
+	if(!UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->bPersistPoolsAcrossSeamlessTravel)
 	{
-		FActorPool* Pool = PoolPointer->Get();
-		AActor* Actor = Pool->Pop();
-		OnActorLeftPool(Actor, PopData);
-		if (Pool->ShouldGrow())
+		return;
+	}
+
+	UActorPoolGameInstanceSubsystem* GameInstanceSubsystem = UActorPoolGameInstanceSubsystem::GetActorPoolGameInstanceSubsystem(this);
+	if(!GameInstanceSubsystem)
+	{
+		return;
+	}
+
+	// Hand our persistent pools to the game instance and stop tracking them, this world is about to be torn down
+	for(auto It = PoolMap.CreateIterator(); It; ++It)
+	{
+		if(ShouldPersistPool(It.Key().ActorClass))
 		{
-			FillPool(ActorClass, *Pool, Pool->MinimumPoolSize - Pool->Num());
+			GameInstanceSubsystem->StorePool(It.Key(), It.Value());
+			It.RemoveCurrent();
 		}
-		return Actor;
 	}
 
-	return nullptr;
+	/* This is called once when leaving for the transition map and again when leaving the transition map for the destination,
+	 * without a transition map only the second call happens. Pools are only adopted once they are headed to the destination
+	 */
+	GameInstanceSubsystem->SetTravellingToDestination(!bToTransition);
+	GameInstanceSubsystem->AddPersistentActorsToList(ActorList);
+}
+
+void UActorPoolWorldSubsystem::AdoptPersistentPools()
+{
+	UActorPoolGameInstanceSubsystem* GameInstanceSubsystem = UActorPoolGameInstanceSubsystem::GetActorPoolGameInstanceSubsystem(this);
+	if(!GameInstanceSubsystem || !GameInstanceSubsystem->HasPoolsToAdopt())
+	{
+		return;
+	}
+
+	const UWorld* World = GetWorld();
+	TArray<AActor*> OverflowActors;
+	for(FPersistentActorPool& PersistentPool : GameInstanceSubsystem->TakePersistentPools())
+	{
+		// Only keep actors that were actually moved into our world
+		PersistentPool.ActorPool.Pool.RemoveAll([World](const AActor* Actor)
+		{
+			return !IsValid(Actor) || Actor->GetWorld() != World;
+		});
+
+		if(!IsValidActorClass(PersistentPool.ActorClass) || PersistentPool.ActorPool.Pool.IsEmpty())
+		{
+			continue;
+		}
+
+		// Variant actors are already set up, we only need to remember which pool they go back to
+		const FActorPoolKey PoolKey(PersistentPool.ActorClass, PersistentPool.Variant);
+		if(!PoolKey.Variant.IsDefault())
+		{
+			for(AActor* Actor : PersistentPool.ActorPool.Pool)
+			{
+				TrackPoolVariant(Actor, PoolKey.Variant);
+			}
+		}
+
+		// A pool for the class may have been created before we got to adopt, top it up and destroy whatever doesn't fit
+		if(FActorPool* Pool = PoolMap.Find(PoolKey))
+		{
+			for(AActor* Actor : PersistentPool.ActorPool.Pool)
+			{
+				if(Pool->CanGrow())
+				{
+					Pool->Push(Actor);
+				}
+				else
+				{
+					OverflowActors.Add(Actor);
+				}
+			}
+			continue;
+		}
+
+		PoolMap.Add(PoolKey, MoveTemp(PersistentPool.ActorPool));
+	}
+
+	// Destroy callbacks can change our pools, so only destroy once we are done adopting
+	for(AActor* Actor : OverflowActors)
+	{
+		Actor->Destroy();
+	}
+}
+
+bool UActorPoolWorldSubsystem::SavePoolUsageProfile()
+{
+	if(!SaveSessionUsageProfile())
+	{
+		return false;
+	}
+
+	if(UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->bAutoMergePoolUsageProfiles)
+	{
+		MergePoolUsageProfiles(GetPoolUsageProfileMapName(), GetNetModeName(GetWorld()->GetNetMode()));
+	}
+
+	return true;
+}
+
+bool UActorPoolWorldSubsystem::SaveSessionUsageProfile()
+{
+	if(UsageMap.IsEmpty())
+	{
+		return false;
+	}
+
+	const FString MapName = GetPoolUsageProfileMapName();
+
+	FActorPoolUsageProfile Profile;
+	Profile.MapName = MapName;
+	Profile.NetMode = GetNetModeName(GetWorld()->GetNetMode());
+	Profile.SessionCount = 1;
+	UsageMap.GenerateValueArray(Profile.ClassUsage);
+
+	if(SessionProfilePath.IsEmpty())
+	{
+		SessionProfilePath = FActorPoolUsageProfile::GetSessionDirectory(MapName) /
+			FActorPoolUsageProfile::GetSessionFileName(MapName, Profile.NetMode);
+	}
+
+	if(!Profile.SaveToFile(SessionProfilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not save pool usage profile to %s."), *SessionProfilePath)
+		return false;
+	}
+
+	return true;
+}
+
+bool UActorPoolWorldSubsystem::MergePoolUsageProfiles(const FString& MapName, const FString& NetMode)
+{
+	return FActorPoolUsageProfile::MergeSessionProfiles(MapName, NetMode);
+}
+
+FString UActorPoolWorldSubsystem::GetPoolUsageProfileMapName() const
+{
+	const UWorld* World = GetWorld();
+	return World ? UWorld::RemovePIEPrefix(World->GetMapName()) : FString();
+}
+
+int UActorPoolWorldSubsystem::GetNumPooledActors() const
+{
+	// Actors destroyed while pooled are nulled out by the garbage collector but stay in the pool until popped, don't count them
+	int NumPooledActors = 0;
+	for(const TPair<FActorPoolKey, FActorPool>& Pair : PoolMap)
+	{
+		for(const AActor* Actor : Pair.Value.Pool)
+		{
+			NumPooledActors += IsValid(Actor) ? 1 : 0;
+		}
+	}
+
+	return NumPooledActors;
+}
+
+float UActorPoolWorldSubsystem::MeasureGarbageCollectionTime(int Iterations)
+{
+	Iterations = FMath::Max(Iterations, 1);
+
+	double TotalSeconds = 0.0;
+	for(int i = 0; i < Iterations; i++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		TotalSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	const float AverageMilliseconds = static_cast<float>(TotalSeconds / Iterations * 1000.0);
+	UE_LOG(LogTemp, Display, TEXT("Garbage collection took %.3f ms on average over %d runs with %d pooled actors in %d pools."),
+		AverageMilliseconds, Iterations, GetNumPooledActors(), PoolMap.Num())
+
+	return AverageMilliseconds;
+}
+
+void UActorPoolWorldSubsystem::PrewarmPendingPools()
+{
+	int ActorBudget = UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->PrewarmActorsPerFrame;
+
+	while(ActorBudget > 0 && !PendingPrewarmData.IsEmpty())
+	{
+		const FDefaultActorPoolData Data = PendingPrewarmData[0];
+		const FActorPoolKey PoolKey(Data.ActorClass, Data.PoolVariant);
+
+		// Create the pool with only its minimum amount of actors so it can be requested from right away, the rest is spawned over the following frames
+		if(!PoolMap.Contains(PoolKey))
+		{
+			if(!CreateVariantPool(Data.ActorClass, Data.PoolVariant, Data.MinimumPoolSize, Data.MaximumPoolSize, Data.MinimumPoolSize))
+			{
+				PendingPrewarmData.RemoveAt(0);
+				continue;
+			}
+
+			ActorBudget -= FMath::Max(Data.MinimumPoolSize, 1);
+		}
+
+		FActorPool* Pool = PoolMap.Find(PoolKey);
+		Pool->MaximumPoolSize = FMath::Max(Pool->MaximumPoolSize, Data.PoolSize);
+		const int SpawnAmount = FMath::Min(FMath::Max(ActorBudget, 0), Data.PoolSize - Pool->Num());
+
+		if(SpawnAmount > 0)
+		{
+			// Spawn into a separate array first, callbacks on the new actors could create pools and move ours in memory
+			TArray<AActor*> NewActors;
+			FillPool(PoolKey, NewActors, SpawnAmount);
+			ActorBudget -= SpawnAmount;
+
+			Pool = PoolMap.Find(PoolKey);
+			if(Pool)
+			{
+				Pool->Pool.Append(NewActors);
+			}
+		}
+
+		if(!Pool || Pool->Num() >= Data.PoolSize)
+		{
+			PendingPrewarmData.RemoveAt(0);
+		}
+	}
+
+	if(!PendingPrewarmData.IsEmpty())
+	{
+		PrewarmTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UActorPoolWorldSubsystem::PrewarmPendingPools);
+	}
+}
+
+AActor* UActorPoolWorldSubsystem::PopActorOfType(const FActorPoolKey& PoolKey, const FActorPopData& PopData)
+{
+	FActorPool* Pool = PoolMap.Find(PoolKey);
+	if (!Pool)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = Pool->Pop();
+	if (Pool->ShouldGrow())
+	{
+		// Spawn into a separate array first, callbacks on the new actors could create pools and move ours in memory
+		TArray<AActor*> NewActors;
+		FillPool(PoolKey, NewActors, Pool->MinimumPoolSize - Pool->Num());
+		if (FActorPool* GrownPool = PoolMap.Find(PoolKey))
+		{
+			GrownPool->Pool.Append(NewActors);
+
+			// Every pooled actor may have been destroyed while pooled, hand out one of the actors we just spawned instead
+			if (!Actor)
+			{
+				Actor = GrownPool->Pop();
+			}
+		}
+	}
+
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	OnActorLeftPool(Actor, PopData);
+	return Actor;
 }
 
 AActor* UActorPoolWorldSubsystem::ForceSpawnActor(TSubclassOf<AActor> ActorClass) const
@@ -244,16 +663,59 @@ bool UActorPoolWorldSubsystem::IsValidActorClass(const TSubclassOf<AActor>& Acto
 	return ActorClass && ActorClass->ImplementsInterface(UPooledActorInterface::StaticClass());
 }
 
-void UActorPoolWorldSubsystem::FillPool(UClass* Class, FActorPool& ActorPool, const int ActorSpawnAmount) const
+AActor* UActorPoolWorldSubsystem::SpawnPooledActor(const FActorPoolKey& PoolKey)
+{
+	AActor* Actor = ForceSpawnActor(PoolKey.ActorClass);
+	if(!Actor || PoolKey.Variant.IsDefault())
+	{
+		return Actor;
+	}
+
+	// Set up the variant once on spawn, the actor keeps it for as long as it lives so pops don't have to reconfigure it
+	TrackPoolVariant(Actor, PoolKey.Variant);
+	IPooledActorInterface::Execute_OnPoolVariantAssigned(Actor, PoolKey.Variant);
+
+	TArray<UActorComponent*> ActorPooledInterfaceComponents = Actor->GetComponentsByInterface(UPooledActorInterface::StaticClass());
+	for(int i = 0; i < ActorPooledInterfaceComponents.Num(); i++)
+	{
+		UActorComponent* ActorComponent = ActorPooledInterfaceComponents[i];
+		IPooledActorInterface::Execute_OnPoolVariantAssigned(ActorComponent, PoolKey.Variant);
+	}
+
+	return Actor;
+}
+
+void UActorPoolWorldSubsystem::FillPool(const FActorPoolKey& PoolKey, TArray<AActor*>& OutActors, const int ActorSpawnAmount)
 {
+	OutActors.Reserve(OutActors.Num() + ActorSpawnAmount);
 	for(int i = 0; i < ActorSpawnAmount; i++)
 	{
-		AActor* Actor = ForceSpawnActor(Class);
+		AActor* Actor = SpawnPooledActor(PoolKey);
 		OnActorEnteredPool(Actor);
-		ActorPool.Push(Actor);
+		OutActors.Push(Actor);
 	}
 }
 
+FActorPoolKey UActorPoolWorldSubsystem::GetPoolKey(AActor* Actor) const
+{
+	const FActorPoolVariant* Variant = ActorVariantMap.Find(Actor);
+	return FActorPoolKey(Actor->GetClass(), Variant ? *Variant : FActorPoolVariant());
+}
+
+void UActorPoolWorldSubsystem::TrackPoolVariant(AActor* Actor, const FActorPoolVariant& Variant)
+{
+	ActorVariantMap.Add(Actor, Variant);
+	Actor->OnDestroyed.AddUniqueDynamic(this, &UActorPoolWorldSubsystem::OnPooledActorDestroyed);
+}
+
+void UActorPoolWorldSubsystem::OnPooledActorDestroyed(AActor* DestroyedActor)
+{
+	ActorVariantMap.Remove(DestroyedActor);
+
+	// Checked out actors destroyed by gameplay are never returned, they are no longer out of the pool either
+	RecordActorReturnedToPool(DestroyedActor);
+}
+
 void UActorPoolWorldSubsystem::ReleaseFromPool(FActorPool& ActorPool, const int ActorRemoveAmount)
 {
 	if(ActorPool.Pool.IsEmpty())
@@ -297,14 +759,14 @@ void UActorPoolWorldSubsystem::OnActorLeftPool(AActor* Actor, const FActorPopDat
 	Actor->SetActorTickEnabled(Settings.ShouldUseTick());
 	Actor->SetActorHiddenInGame(Settings.ShouldHideInGame());
 
-	IPooledActorInterface::Execute_OnPoolLeft(Actor, PopData);
+	DispatchOnPoolLeft(Actor, PopData);
 	
 	// Iterate over all actor components that implement pooled actor interface for initial setup
 	TArray<UActorComponent*> ActorPooledInterfaceComponents = Actor->GetComponentsByInterface(UPooledActorInterface::StaticClass());
 	for(int i = 0; i < ActorPooledInterfaceComponents.Num(); i++)
 	{
 		UActorComponent* ActorComponent = ActorPooledInterfaceComponents[i];
-		IPooledActorInterface::Execute_OnPoolLeft(ActorComponent, PopData);
+		DispatchOnPoolLeft(ActorComponent, PopData);
 	}
 
 	// Enable collision after calling everything else, that way we won't call overlap events until setup is complete
@@ -313,14 +775,14 @@ void UActorPoolWorldSubsystem::OnActorLeftPool(AActor* Actor, const FActorPopDat
 
 void UActorPoolWorldSubsystem::OnActorEnteredPool(AActor* Actor) const
 {
-	IPooledActorInterface::Execute_OnPoolEntered(Actor);
+	DispatchOnPoolEntered(Actor);
 
 	// Iterate over all actor components that implement pooled actor interface for de-initialization
 	TArray<UActorComponent*> ActorPooledInterfaceComponents = Actor->GetComponentsByInterface(UPooledActorInterface::StaticClass());
 	for(int i = 0; i < ActorPooledInterfaceComponents.Num(); i++)
 	{
 		UActorComponent* ActorComponent = ActorPooledInterfaceComponents[i];
-		IPooledActorInterface::Execute_OnPoolEntered(ActorComponent);
+		DispatchOnPoolEntered(ActorComponent);
 	}
 
 	/* Interface functions are called before doing pool optimizations,
@@ -340,3 +802,249 @@ void UActorPoolWorldSubsystem::OnActorEnteredPool(AActor* Actor) const
 	Actor->SetActorHiddenInGame(true);
 	Actor->SetReplicates(false);
 }
+
+float UActorPoolWorldSubsystem::BenchmarkPoolCallbacks(TSubclassOf<AActor> ActorClass, int Iterations)
+{
+	if(!IsValidActorClass(ActorClass))
+	{
+		return 0.f;
+	}
+
+	// Pop and push directly rather than requesting, the benchmark shouldn't show up in recorded pool usage
+	const FActorPoolKey PoolKey(ActorClass);
+	if(!PoolMap.Contains(PoolKey))
+	{
+		CreatePool(ActorClass, DefaultMinimumPoolSize, DefaultMaximumPoolSize, DefaultPoolSize);
+	}
+
+	const FActorPopData PopData = FActorPopData();
+	AActor* Actor = PopActorOfType(PoolKey, PopData);
+	if(!Actor)
+	{
+		return 0.f;
+	}
+
+	Iterations = FMath::Max(Iterations, 1);
+	const TArray<UActorComponent*> ActorPooledInterfaceComponents = Actor->GetComponentsByInterface(UPooledActorInterface::StaticClass());
+
+	// Both runs call the same callbacks, so the difference between them is only the cost of dispatching
+	double StartTime = FPlatformTime::Seconds();
+	for(int i = 0; i < Iterations; i++)
+	{
+		IPooledActorInterface::Execute_OnPoolLeft(Actor, PopData);
+		for(UActorComponent* ActorComponent : ActorPooledInterfaceComponents)
+		{
+			IPooledActorInterface::Execute_OnPoolLeft(ActorComponent, PopData);
+		}
+	}
+	const double EventSeconds = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for(int i = 0; i < Iterations; i++)
+	{
+		DispatchOnPoolLeft(Actor, PopData);
+		for(UActorComponent* ActorComponent : ActorPooledInterfaceComponents)
+		{
+			DispatchOnPoolLeft(ActorComponent, PopData);
+		}
+	}
+	const double DispatchSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const float EventNanoseconds = static_cast<float>(EventSeconds / Iterations * 1.0e9);
+	const float DispatchNanoseconds = static_cast<float>(DispatchSeconds / Iterations * 1.0e9);
+	const FPooledActorCallbackDispatch& Dispatch = GetCallbackDispatch(Actor->GetClass());
+	UE_LOG(LogTemp, Display, TEXT("%s pool callbacks with %d components: Blueprint event dispatch %.1f ns per pop, native dispatch %.1f ns per pop (actor native: %s)."),
+		*ActorClass->GetName(), ActorPooledInterfaceComponents.Num(), EventNanoseconds, DispatchNanoseconds,
+		Dispatch.bNativeOnPoolLeft ? TEXT("true") : TEXT("false"))
+
+	FActorPool* Pool = PoolMap.Find(PoolKey);
+	if(Pool && Pool->CanGrow())
+	{
+		Pool->Push(Actor);
+		OnActorEnteredPool(Actor);
+	}
+	else
+	{
+		Actor->Destroy();
+	}
+
+	return DispatchNanoseconds;
+}
+
+bool UActorPoolWorldSubsystem::ShouldPersistPool(const UClass* Class)
+{
+	const TArray<TSoftClassPtr<AActor>>& PersistentPoolClasses =
+		UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->PersistentPoolClasses;
+
+	// A class that isn't loaded can't have any pooled children, so we don't need to load it
+	return PersistentPoolClasses.ContainsByPredicate([Class](const TSoftClassPtr<AActor>& PersistentPoolClass)
+	{
+		return PersistentPoolClass.Get() && Class->IsChildOf(PersistentPoolClass.Get());
+	});
+}
+
+void UActorPoolWorldSubsystem::ApplyPoolUsageProfile(TArray<FDefaultActorPoolData>& PoolData) const
+{
+	FActorPoolUsageProfile Profile;
+	// Servers and clients use pools very differently, only size pools from sessions recorded in the same net mode
+	if(!Profile.LoadFromFile(FActorPoolUsageProfile::GetProfilePath(GetPoolUsageProfileMapName(), GetNetModeName(GetWorld()->GetNetMode()))))
+	{
+		return;
+	}
+
+	const float Headroom = UActorPoolingDeveloperSettings::StaticClass()->GetDefaultObject<UActorPoolingDeveloperSettings>()->PoolUsageProfileHeadroom;
+
+	// Pools that were used in previous sessions but don't have a default pool yet get one added with our default sizes
+	for(const FActorPoolClassUsage& Usage : Profile.ClassUsage)
+	{
+		UClass* UsageClass = Usage.ActorClass.LoadSynchronous();
+		FActorPoolVariant UsageVariant;
+		UsageVariant.VariantTag = Usage.VariantTag;
+		UsageVariant.VariantAsset = Usage.VariantAsset.LoadSynchronous();
+
+		// Skip pools whose class or variant asset no longer exists
+		if(!IsValidActorClass(UsageClass) || (!Usage.VariantAsset.IsNull() && !UsageVariant.VariantAsset))
+		{
+			continue;
+		}
+
+		const bool bHasDefaultPool = PoolData.ContainsByPredicate([UsageClass, &UsageVariant](const FDefaultActorPoolData& Data)
+		{
+			return Data.ActorClass == UsageClass && Data.PoolVariant == UsageVariant;
+		});
+
+		if(!bHasDefaultPool)
+		{
+			FDefaultActorPoolData& Data = PoolData.AddDefaulted_GetRef();
+			Data.ActorClass = UsageClass;
+			Data.PoolVariant = UsageVariant;
+			Data.MinimumPoolSize = DefaultMinimumPoolSize;
+			Data.MaximumPoolSize = DefaultMaximumPoolSize;
+		}
+	}
+
+	/* Size each pool to the peak amount of actors that were out at once plus some headroom,
+	 * pools that were never used during any recorded session only get their minimum amount of actors
+	 */
+	for(FDefaultActorPoolData& Data : PoolData)
+	{
+		if(const FActorPoolClassUsage* Usage = Profile.FindClassUsage(Data.ActorClass, Data.PoolVariant))
+		{
+			Data.PoolSize = FMath::Max(Data.MinimumPoolSize, FMath::CeilToInt(Usage->PeakCheckedOut * Headroom));
+			Data.MaximumPoolSize = FMath::Max(Data.MaximumPoolSize, Data.PoolSize);
+		}
+		else
+		{
+			Data.PoolSize = Data.MinimumPoolSize;
+		}
+	}
+
+	// Prewarm the classes that were needed first before the rest, unused classes keep their authored order at the end
+	PoolData.StableSort([&Profile](const FDefaultActorPoolData& A, const FDefaultActorPoolData& B)
+	{
+		const FActorPoolClassUsage* UsageA = Profile.FindClassUsage(A.ActorClass, A.PoolVariant);
+		const FActorPoolClassUsage* UsageB = Profile.FindClassUsage(B.ActorClass, B.PoolVariant);
+
+		if(UsageA && UsageB)
+		{
+			return UsageA->TimeToFirstUse < UsageB->TimeToFirstUse;
+		}
+
+		return UsageA && !UsageB;
+	});
+}
+
+void UActorPoolWorldSubsystem::RecordPoolRequest(const FActorPoolKey& PoolKey)
+{
+	if(!bRecordingPoolUsage || UsageMap.Contains(PoolKey))
+	{
+		return;
+	}
+
+	FActorPoolClassUsage& Usage = UsageMap.Add(PoolKey);
+	Usage.ActorClass = PoolKey.ActorClass;
+	Usage.VariantTag = PoolKey.Variant.VariantTag;
+	Usage.VariantAsset = PoolKey.Variant.VariantAsset;
+	Usage.TimeToFirstUse = GetWorld()->GetTimeSeconds();
+}
+
+void UActorPoolWorldSubsystem::RecordPoolMiss(const FActorPoolKey& PoolKey)
+{
+	if(FActorPoolClassUsage* Usage = bRecordingPoolUsage ? UsageMap.Find(PoolKey) : nullptr)
+	{
+		Usage->MissCount++;
+	}
+}
+
+void UActorPoolWorldSubsystem::RecordActorLeftPool(const FActorPoolKey& PoolKey, AActor* Actor)
+{
+	if(FActorPoolClassUsage* Usage = bRecordingPoolUsage ? UsageMap.Find(PoolKey) : nullptr)
+	{
+		Usage->CheckedOut++;
+		Usage->PeakCheckedOut = FMath::Max(Usage->PeakCheckedOut, Usage->CheckedOut);
+
+		CheckedOutActors.Add(Actor, PoolKey);
+		Actor->OnDestroyed.AddUniqueDynamic(this, &UActorPoolWorldSubsystem::OnPooledActorDestroyed);
+	}
+}
+
+void UActorPoolWorldSubsystem::RecordActorReturnedToPool(AActor* Actor)
+{
+	// Actors spawned outside of the pool can be added as well, only actors we handed out count as returned
+	FActorPoolKey PoolKey;
+	if(!CheckedOutActors.RemoveAndCopyValue(Actor, PoolKey))
+	{
+		return;
+	}
+
+	if(FActorPoolClassUsage* Usage = UsageMap.Find(PoolKey))
+	{
+		Usage->CheckedOut--;
+	}
+}
+
+const FPooledActorCallbackDispatch& UActorPoolWorldSubsystem::GetCallbackDispatch(const UClass* Class) const
+{
+	if(const FPooledActorCallbackDispatch* Dispatch = CallbackDispatchMap.Find(Class))
+	{
+		return *Dispatch;
+	}
+
+	FPooledActorCallbackDispatch& Dispatch = CallbackDispatchMap.Add(Class);
+
+	// Only classes implementing the interface in C++ can be cast to it, Blueprint implementations have to go through event dispatch
+	if(!Cast<IPooledActorInterface>(Class->GetDefaultObject()))
+	{
+		return Dispatch;
+	}
+
+	// Blueprint overrides of the events are script functions, native implementations resolve to the interface's native function
+	const UFunction* OnPoolEnteredFunction = Class->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(IPooledActorInterface, OnPoolEntered));
+	const UFunction* OnPoolLeftFunction = Class->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(IPooledActorInterface, OnPoolLeft));
+
+	Dispatch.bNativeOnPoolEntered = OnPoolEnteredFunction && OnPoolEnteredFunction->HasAnyFunctionFlags(FUNC_Native);
+	Dispatch.bNativeOnPoolLeft = OnPoolLeftFunction && OnPoolLeftFunction->HasAnyFunctionFlags(FUNC_Native);
+	return Dispatch;
+}
+
+void UActorPoolWorldSubsystem::DispatchOnPoolLeft(UObject* Object, const FActorPopData& PopData) const
+{
+	if(GetCallbackDispatch(Object->GetClass()).bNativeOnPoolLeft)
+	{
+		Cast<IPooledActorInterface>(Object)->OnPoolLeft_Implementation(PopData);
+		return;
+	}
+
+	IPooledActorInterface::Execute_OnPoolLeft(Object, PopData);
+}
+
+void UActorPoolWorldSubsystem::DispatchOnPoolEntered(UObject* Object) const
+{
+	if(GetCallbackDispatch(Object->GetClass()).bNativeOnPoolEntered)
+	{
+		Cast<IPooledActorInterface>(Object)->OnPoolEntered_Implementation();
+		return;
+	}
+
+	IPooledActorInterface::Execute_OnPoolEntered(Object);
+}
@@ -2,6 +2,12 @@
 
 
 #include "PoolTypes.h"
+#include "JsonObjectConverter.h"
+#include "HAL/FileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
 
 bool FActorPool::ShouldGrow() const
 {
@@ -25,9 +31,14 @@ void FActorPool::Push(AActor* Actor)
 
 AActor* FActorPool::Pop()
 {
-	if(!Pool.IsEmpty())
+	// Actors destroyed while pooled are nulled out by the garbage collector, skip over them
+	while(!Pool.IsEmpty())
 	{
-		return Pool.Pop();
+		AActor* Actor = Pool.Pop();
+		if(IsValid(Actor))
+		{
+			return Actor;
+		}
 	}
 
 	return nullptr;
@@ -42,3 +53,154 @@ bool FActorPool::ContainsActor(AActor* Actor) const
 {
 	return Pool.Contains(Actor);
 }
+
+void FActorPoolClassUsage::Merge(const FActorPoolClassUsage& Other)
+{
+	// Size for the worst session, but prewarm as early as the earliest session needed the class
+	PeakCheckedOut = FMath::Max(PeakCheckedOut, Other.PeakCheckedOut);
+	TimeToFirstUse = FMath::Min(TimeToFirstUse, Other.TimeToFirstUse);
+	MissCount += Other.MissCount;
+	SessionCount += Other.SessionCount;
+}
+
+FString FActorPoolUsageProfile::GetProfileDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ActorPoolProfiles");
+}
+
+FString FActorPoolUsageProfile::GetProfilePath(const FString& InMapName, const FString& InNetMode)
+{
+	return GetProfileDirectory() / FString::Printf(TEXT("%s_%s.json"), *InMapName, *InNetMode);
+}
+
+FString FActorPoolUsageProfile::GetSessionDirectory(const FString& InMapName)
+{
+	return GetProfileDirectory() / TEXT("Sessions") / InMapName;
+}
+
+FString FActorPoolUsageProfile::GetSessionFileName(const FString& InMapName, const FString& InNetMode)
+{
+	/* Every session gets its own file so sessions from different playtests can be collected into the same folder and merged later,
+	 * servers and clients in the same play session tear down at the same time so the name needs more than a timestamp to be unique
+	 */
+	return FString::Printf(TEXT("%s_%s_%s_%s.json"), *InMapName, *InNetMode,
+		*FDateTime::Now().ToString(), *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+}
+
+bool FActorPoolUsageProfile::MergeSessionProfiles(const FString& InMapName, const FString& InNetMode)
+{
+	const FString SessionDirectory = GetSessionDirectory(InMapName);
+
+	TArray<FString> SessionFiles;
+	IFileManager::Get().FindFiles(SessionFiles, *SessionDirectory, TEXT("json"));
+
+	/* Always rebuild from the session files rather than merging into the existing profile,
+	 * that way merging multiple times or after adding sessions from other playtests doesn't count sessions twice
+	 */
+	TMap<FString, FActorPoolUsageProfile> MergedProfiles;
+	const FString SessionPrefix = InMapName + TEXT("_");
+
+	for(const FString& SessionFile : SessionFiles)
+	{
+		// Session files are named <Map>_<NetMode>_<Time>_<Guid>, the map name can contain underscores so only split after it
+		FString SessionNetMode;
+		if(!SessionFile.StartsWith(SessionPrefix) || !SessionFile.RightChop(SessionPrefix.Len()).Split(TEXT("_"), &SessionNetMode, nullptr))
+		{
+			continue;
+		}
+
+		if(!InNetMode.IsEmpty() && SessionNetMode != InNetMode)
+		{
+			continue;
+		}
+
+		FActorPoolUsageProfile SessionProfile;
+		if(SessionProfile.LoadFromFile(SessionDirectory / SessionFile))
+		{
+			FActorPoolUsageProfile* MergedProfile = MergedProfiles.Find(SessionNetMode);
+			if(!MergedProfile)
+			{
+				MergedProfile = &MergedProfiles.Add(SessionNetMode);
+				MergedProfile->MapName = InMapName;
+				MergedProfile->NetMode = SessionNetMode;
+			}
+
+			MergedProfile->Merge(SessionProfile);
+		}
+	}
+
+	if(MergedProfiles.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No pool usage sessions found for map %s, could not merge profiles."), *InMapName)
+		return false;
+	}
+
+	bool bSaved = true;
+	for(const TPair<FString, FActorPoolUsageProfile>& Pair : MergedProfiles)
+	{
+		bSaved &= Pair.Value.SaveToFile(GetProfilePath(InMapName, Pair.Key));
+	}
+
+	return bSaved;
+}
+
+bool FActorPoolUsageProfile::LoadFromFile(const FString& FilePath)
+{
+	FString JsonString;
+	if(!FFileHelper::LoadFileToString(JsonString, *FilePath))
+	{
+		return false;
+	}
+
+	if(!FJsonObjectConverter::JsonObjectStringToUStruct(JsonString, this))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Pool usage profile %s could not be read."), *FilePath)
+		return false;
+	}
+
+	return true;
+}
+
+bool FActorPoolUsageProfile::SaveToFile(const FString& FilePath) const
+{
+	FString JsonString;
+	if(!FJsonObjectConverter::UStructToJsonObjectString(*this, JsonString))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(JsonString, *FilePath);
+}
+
+void FActorPoolUsageProfile::Merge(const FActorPoolUsageProfile& Other)
+{
+	SessionCount += Other.SessionCount;
+
+	for(const FActorPoolClassUsage& OtherUsage : Other.ClassUsage)
+	{
+		FActorPoolClassUsage* Usage = ClassUsage.FindByPredicate([&OtherUsage](const FActorPoolClassUsage& ExistingUsage)
+		{
+			return ExistingUsage.IsSamePool(OtherUsage.ActorClass, OtherUsage.VariantTag, OtherUsage.VariantAsset);
+		});
+
+		if(Usage)
+		{
+			Usage->Merge(OtherUsage);
+		}
+		else
+		{
+			ClassUsage.Add(OtherUsage);
+		}
+	}
+}
+
+const FActorPoolClassUsage* FActorPoolUsageProfile::FindClassUsage(UClass* ActorClass, const FActorPoolVariant& Variant) const
+{
+	const TSoftClassPtr<AActor> SoftActorClass(ActorClass);
+	const TSoftObjectPtr<UObject> SoftVariantAsset(Variant.VariantAsset);
+
+	return ClassUsage.FindByPredicate([&](const FActorPoolClassUsage& Usage)
+	{
+		return Usage.IsSamePool(SoftActorClass, Variant.VariantTag, SoftVariantAsset);
+	});
+}
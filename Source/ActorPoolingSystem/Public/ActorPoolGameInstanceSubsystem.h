@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PoolTypes.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ActorPoolGameInstanceSubsystem.generated.h"
+
+/**
+ * Holds pools that are persisted across seamless travel while the worlds they belong to are being swapped out
+ */
+UCLASS()
+class ACTORPOOLINGSYSTEM_API UActorPoolGameInstanceSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	UPROPERTY()
+	TArray<FPersistentActorPool> PersistentPools;
+
+	/* Set once the pools have been handed to the travel actor list for the destination world, pools are only adopted after that */
+	bool bTravellingToDestination = false;
+
+public:
+
+	static UActorPoolGameInstanceSubsystem* GetActorPoolGameInstanceSubsystem(const UObject* WorldContextObject);
+
+	void StorePool(const FActorPoolKey& PoolKey, const FActorPool& ActorPool);
+
+	void AddPersistentActorsToList(TArray<AActor*>& ActorList) const;
+
+	void SetTravellingToDestination(const bool bInTravellingToDestination);
+
+	bool HasPoolsToAdopt() const;
+
+	/* Removes and returns all stored pools so the destination world can take ownership of them */
+	TArray<FPersistentActorPool> TakePersistentPools();
+};
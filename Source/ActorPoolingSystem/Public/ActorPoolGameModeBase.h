@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "ActorPoolGameModeBase.generated.h"
+
+/**
+ * Game mode that carries persistent actor pools through seamless travel, derive from this to persist pools without any C++
+ */
+UCLASS()
+class ACTORPOOLINGSYSTEM_API AActorPoolGameModeBase : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList) override;
+};
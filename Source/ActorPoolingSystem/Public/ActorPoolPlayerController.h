@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "ActorPoolPlayerController.generated.h"
+
+/**
+ * Player controller that carries persistent actor pools through seamless travel on clients, which don't have a game mode to do it
+ */
+UCLASS()
+class ACTORPOOLINGSYSTEM_API AActorPoolPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GetSeamlessTravelActorList(bool bToEntry, TArray<AActor*>& ActorList) override;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "PoolTypes.h"
+#include "Engine/EngineTypes.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "ActorPoolWorldSubsystem.generated.h"
 
@@ -21,10 +22,42 @@ private:
 	/* Soft Object Pointer to a Data Table containing default actor pool data that can be used on setup */
 	static const TSoftObjectPtr<UDataTable> DefaultActorPoolDataTable;
 	
-	TMap<UClass*, TSharedPtr<FActorPool>> PoolMap;
+	/* Pools are reflected so the garbage collector keeps pooled actors alive and nulls out actors destroyed while pooled.
+	 * Pooled actors are deliberately not put into GC clusters, cluster references are fixed when joining so anything an actor
+	 * references after leaving the pool would be invisible to the collector, and destroying a clustered actor dissolves the whole cluster
+	 */
+	UPROPERTY()
+	TMap<FActorPoolKey, FActorPool> PoolMap;
+
+	/* Variant each actor spawned for a variant pool was set up as, so it can be returned to the right pool */
+	UPROPERTY()
+	TMap<TWeakObjectPtr<AActor>, FActorPoolVariant> ActorVariantMap;
 
+	UPROPERTY()
 	TMap<UClass*, FPooledActorSettings> ActorSettingsMap;
 
+	/* Usage of each requested pool during this session, only filled while recording pool usage profiles */
+	UPROPERTY()
+	TMap<FActorPoolKey, FActorPoolClassUsage> UsageMap;
+
+	/* Pool each actor currently out of a pool was requested from, so returned or destroyed actors are only counted once */
+	UPROPERTY()
+	TMap<TWeakObjectPtr<AActor>, FActorPoolKey> CheckedOutActors;
+
+	bool bRecordingPoolUsage = false;
+
+	/* Saving more than once during a session overwrites the same file, so the session is only merged once */
+	FString SessionProfilePath;
+
+	/* Default pools still being prewarmed over multiple frames, in the order they are prewarmed */
+	UPROPERTY()
+	TArray<FDefaultActorPoolData> PendingPrewarmData;
+
+	FTimerHandle PrewarmTimerHandle;
+
+	/* Cached per class, actors and components are checked every time they enter or leave a pool. Only a cache, so it doesn't keep classes alive */
+	mutable TMap<TWeakObjectPtr<const UClass>, FPooledActorCallbackDispatch> CallbackDispatchMap;
+
 protected:
 
 	UPROPERTY()
@@ -48,6 +81,8 @@ public:
 
 	virtual void Deinitialize() override;
 
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
 // End of Subsystem overrides
 
 public:
@@ -58,6 +93,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
 	void SetupActorPoolDefaults();
+
+	UFUNCTION(BlueprintPure, Category = "Actor Pool World Subsystem")
+	bool IsPrewarmingPools() const;
 	
 	template<class T>
 	T* RequestActorFromPool(TSubclassOf<AActor> ActorClass, const FActorPopData& PopData)
@@ -77,16 +115,65 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
 	bool CreatePool(TSubclassOf<AActor> ActorClass, int MinimumPoolSize = 5, int MaximumPoolSize = 10, int Amount = 10);
 
+	/* Creates a pool of actors that are set up as the variant once when spawned, requests with the same variant in their pop data are served from it */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	bool CreateVariantPool(TSubclassOf<AActor> ActorClass, const FActorPoolVariant& Variant, int MinimumPoolSize = 5, int MaximumPoolSize = 10, int Amount = 10);
+
+	/* Removes the pools of every variant of the class */
 	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
 	bool RemovePool(TSubclassOf<AActor> ActorClass);
 
 	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
 	bool ModifyPoolMinimumSize(TSubclassOf<AActor> ActorClass, const int NewMinimumPoolSize);
 
+	/* Hands pools of the persistent pool classes over to the game instance and adds their actors to the seamless travel actor list,
+	 * so the pools are re-adopted by the next world instead of being refilled. Call this from the game mode's GetSeamlessTravelActorList on the server
+	 * and from the player controller's on clients, or derive from AActorPoolGameModeBase and AActorPoolPlayerController which already do
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	void AddPersistentPoolsToSeamlessTravelList(bool bToTransition, UPARAM(ref) TArray<AActor*>& ActorList);
+
+	/* Takes ownership of pools persisted through seamless travel, called on begin play and before setting up default pools */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	void AdoptPersistentPools();
+
+	/* Saves the usage recorded so far as a session profile for the current map and merges it if auto merging is enabled.
+	 * The session is also saved automatically when the world is torn down, but never merged then
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	bool SavePoolUsageProfile();
+
+	/* Merges all recorded session profiles for a map, including sessions copied over from other playtests, into the profile used for prewarming.
+	 * Each net mode gets its own profile, leave NetMode empty to merge every net mode that has recorded sessions
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	static bool MergePoolUsageProfiles(const FString& MapName, const FString& NetMode = TEXT(""));
+
+	UFUNCTION(BlueprintPure, Category = "Actor Pool World Subsystem")
+	FString GetPoolUsageProfileMapName() const;
+
+	UFUNCTION(BlueprintPure, Category = "Actor Pool World Subsystem")
+	int GetNumPooledActors() const;
+
+	/* Runs a full garbage collection the specified amount of times and returns the average time in milliseconds,
+	 * logging how many pooled actors were alive so runs with and without pools can be compared.
+	 * Collects garbage synchronously, so it is only meant for the ActorPool.MeasureGC console command
+	 */
+	float MeasureGarbageCollectionTime(int Iterations = 5);
+
+	/* Times calling OnPoolLeft on an actor of the class and its components through Blueprint event dispatch and through our dispatch,
+	 * logging the cost per pop of both and returning the cost of our dispatch in nanoseconds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Actor Pool World Subsystem")
+	float BenchmarkPoolCallbacks(TSubclassOf<AActor> ActorClass, int Iterations = 10000);
+
 private:
 
 	UFUNCTION()
-	AActor* PopActorOfType(TSubclassOf<AActor> ActorClass, const FActorPopData& PopData);
+	void PrewarmPendingPools();
+
+	UFUNCTION()
+	AActor* PopActorOfType(const FActorPoolKey& PoolKey, const FActorPopData& PopData);
 
 	UFUNCTION()
 	AActor* ForceSpawnActor(TSubclassOf<AActor> ActorClass) const;
@@ -95,7 +182,19 @@ private:
 	static bool IsValidActorClass(const TSubclassOf<AActor>& ActorClass);
 
 	UFUNCTION()
-	void FillPool(UClass* Class, FActorPool& ActorPool, const int ActorSpawnAmount) const;
+	AActor* SpawnPooledActor(const FActorPoolKey& PoolKey);
+
+	UFUNCTION()
+	void FillPool(const FActorPoolKey& PoolKey, TArray<AActor*>& OutActors, const int ActorSpawnAmount);
+
+	UFUNCTION()
+	FActorPoolKey GetPoolKey(AActor* Actor) const;
+
+	UFUNCTION()
+	void TrackPoolVariant(AActor* Actor, const FActorPoolVariant& Variant);
+
+	UFUNCTION()
+	void OnPooledActorDestroyed(AActor* DestroyedActor);
 
 	UFUNCTION()
 	void ReleaseFromPool(FActorPool& ActorPool, const int ActorRemoveAmount);
@@ -105,5 +204,34 @@ private:
 
 	UFUNCTION()
 	void OnActorEnteredPool(AActor* Actor) const;
+
+	const FPooledActorCallbackDispatch& GetCallbackDispatch(const UClass* Class) const;
+
+	UFUNCTION()
+	void DispatchOnPoolLeft(UObject* Object, const FActorPopData& PopData) const;
+
+	UFUNCTION()
+	void DispatchOnPoolEntered(UObject* Object) const;
+
+	UFUNCTION()
+	static bool ShouldPersistPool(const UClass* Class);
+
+	UFUNCTION()
+	bool SaveSessionUsageProfile();
+
+	UFUNCTION()
+	void ApplyPoolUsageProfile(TArray<FDefaultActorPoolData>& PoolData) const;
+
+	UFUNCTION()
+	void RecordPoolRequest(const FActorPoolKey& PoolKey);
+
+	UFUNCTION()
+	void RecordPoolMiss(const FActorPoolKey& PoolKey);
+
+	UFUNCTION()
+	void RecordActorLeftPool(const FActorPoolKey& PoolKey, AActor* Actor);
+
+	UFUNCTION()
+	void RecordActorReturnedToPool(AActor* Actor);
 	
 };
@@ -18,7 +18,42 @@ class ACTORPOOLINGSYSTEM_API UActorPoolingDeveloperSettings : public UDeveloperS
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Default Actor Pools")
 	TArray<TSoftObjectPtr<UDataTable>> DefaultActorPoolPaths;
 
+	/* Maximum amount of actors spawned per frame while prewarming default pools, pools are prewarmed in order so profiles can prewarm the first needed ones first.
+	 * 0 prewarms every default pool at once when setting them up
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Default Actor Pools", meta = (ClampMin = "0"))
+	int PrewarmActorsPerFrame = 0;
+
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Actor Pool Settings")
 	TArray<TSoftObjectPtr<UDataTable>> ActorPoolSettingsPaths;
+
+	/* Record peak checked out count, misses and time to first use of each pooled class while playing and save it as a profile for the map */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Pool Usage Profiles")
+	bool bRecordPoolUsageProfiles = false;
+
+	/* Merge the session into the map's profile when SavePoolUsageProfile is called during play.
+	 * Sessions saved while the world is torn down are only merged through ActorPool.MergeUsageProfiles or MergePoolUsageProfiles
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Pool Usage Profiles", meta = (EditCondition = "bRecordPoolUsageProfiles"))
+	bool bAutoMergePoolUsageProfiles = false;
+
+	/* Use the saved profile for the map and net mode to size default pools and prewarm the first needed classes first */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Pool Usage Profiles")
+	bool bUsePoolUsageProfiles = false;
+
+	/* Multiplier applied to the recorded peak checked out count when sizing a pool from a profile */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Pool Usage Profiles", meta = (EditCondition = "bUsePoolUsageProfiles", ClampMin = "1.0"))
+	float PoolUsageProfileHeadroom = 1.25f;
+
+	/* Keep pools of the persistent pool classes alive through seamless travel and re-adopt them in the next world instead of refilling them.
+	 * Requires the game mode (server) and player controller (clients) to derive from AActorPoolGameModeBase and AActorPoolPlayerController,
+	 * or to call UActorPoolWorldSubsystem::AddPersistentPoolsToSeamlessTravelList from their GetSeamlessTravelActorList
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Seamless Travel")
+	bool bPersistPoolsAcrossSeamlessTravel = false;
+
+	/* Pools of these classes and their children survive seamless travel */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Seamless Travel", meta = (EditCondition = "bPersistPoolsAcrossSeamlessTravel"))
+	TArray<TSoftClassPtr<AActor>> PersistentPoolClasses;
 	
 };
@@ -23,6 +23,66 @@ enum class EPooledActorToggles: uint8
 };
 ENUM_CLASS_FLAGS(EPooledActorToggles);
 
+/* Configuration a pooled actor is set up as, such as a fire or ice arrow. Actors keep their variant while pooled so they don't need to be reconfigured every pop */
+USTRUCT(BlueprintType)
+struct FActorPoolVariant
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Variant")
+	FGameplayTag VariantTag;
+
+	/* Asset the variant is set up with, such as a mesh, material or effect */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Variant")
+	UObject* VariantAsset = nullptr;
+
+	bool IsDefault() const { return !VariantTag.IsValid() && !VariantAsset; }
+
+	bool operator==(const FActorPoolVariant& Other) const
+	{
+		return VariantTag == Other.VariantTag && VariantAsset == Other.VariantAsset;
+	}
+
+	friend uint32 GetTypeHash(const FActorPoolVariant& Variant)
+	{
+		return HashCombine(GetTypeHash(Variant.VariantTag), GetTypeHash(Variant.VariantAsset));
+	}
+};
+
+/* Identifies a single pool, each variant of an actor class gets its own pool */
+USTRUCT(BlueprintType)
+struct FActorPoolKey
+{
+	GENERATED_BODY()
+
+	FActorPoolKey()
+	{
+		ActorClass = nullptr;
+	}
+
+	FActorPoolKey(UClass* InActorClass, const FActorPoolVariant& InVariant = FActorPoolVariant())
+	{
+		ActorClass = InActorClass;
+		Variant = InVariant;
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Key")
+	UClass* ActorClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Key")
+	FActorPoolVariant Variant;
+
+	bool operator==(const FActorPoolKey& Other) const
+	{
+		return ActorClass == Other.ActorClass && Variant == Other.Variant;
+	}
+
+	friend uint32 GetTypeHash(const FActorPoolKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.ActorClass), GetTypeHash(Key.Variant));
+	}
+};
+
 USTRUCT(BlueprintType)
 struct FPooledActorSettings : public FTableRowBase
 {
@@ -63,6 +123,109 @@ struct FDefaultActorPoolData : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int MaximumPoolSize;
+
+	/* Variant the pooled actors are set up as, leave empty for the class's default pool */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FActorPoolVariant PoolVariant;
+};
+
+/* Usage of a single pooled actor class, recorded while playing a map and merged across play sessions */
+USTRUCT(BlueprintType)
+struct FActorPoolClassUsage
+{
+	GENERATED_BODY()
+
+	FActorPoolClassUsage()
+	{
+		PeakCheckedOut = 0;
+		MissCount = 0;
+		TimeToFirstUse = 0.f;
+		SessionCount = 1;
+		CheckedOut = 0;
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	TSoftClassPtr<AActor> ActorClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	FGameplayTag VariantTag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	TSoftObjectPtr<UObject> VariantAsset;
+
+	/* Highest amount of actors of this class that were out of the pool at the same time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	int PeakCheckedOut;
+
+	/* Amount of requests that could not be served by already pooled actors and had to spawn during play */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	int MissCount;
+
+	/* Seconds after the world started playing that this class was first requested */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	float TimeToFirstUse;
+
+	/* Amount of play sessions that used this class and have been merged into this entry */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	int SessionCount;
+
+	// Actors currently out of the pool, only relevant while recording so it is not saved
+	int CheckedOut;
+
+	bool IsSamePool(const TSoftClassPtr<AActor>& InActorClass, const FGameplayTag& InVariantTag, const TSoftObjectPtr<UObject>& InVariantAsset) const
+	{
+		return ActorClass == InActorClass && VariantTag == InVariantTag && VariantAsset == InVariantAsset;
+	}
+
+	void Merge(const FActorPoolClassUsage& Other);
+};
+
+/* Pool usage of every requested class for a single map, saved to disk so it can size and order prewarming on the next load */
+USTRUCT(BlueprintType)
+struct FActorPoolUsageProfile
+{
+	GENERATED_BODY()
+
+	FActorPoolUsageProfile()
+	{
+		SessionCount = 0;
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	FString MapName;
+
+	/* Servers and clients use pools very differently, so each net mode keeps its own profile */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	FString NetMode;
+
+	/* Amount of play sessions merged into this profile */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	int SessionCount;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Usage")
+	TArray<FActorPoolClassUsage> ClassUsage;
+
+	// Directory all profiles are saved to, merged profiles live at the root and single session profiles in a folder per map
+	static FString GetProfileDirectory();
+
+	static FString GetProfilePath(const FString& InMapName, const FString& InNetMode);
+
+	static FString GetSessionDirectory(const FString& InMapName);
+
+	static FString GetSessionFileName(const FString& InMapName, const FString& InNetMode);
+
+	/* Merges every session profile recorded for the map in the net mode into a single profile and saves it as the profile used for prewarming,
+	 * an empty net mode merges each net mode that has recorded sessions into its own profile
+	 */
+	static bool MergeSessionProfiles(const FString& InMapName, const FString& InNetMode);
+
+	bool LoadFromFile(const FString& FilePath);
+
+	bool SaveToFile(const FString& FilePath) const;
+
+	void Merge(const FActorPoolUsageProfile& Other);
+
+	const FActorPoolClassUsage* FindClassUsage(UClass* ActorClass, const FActorPoolVariant& Variant) const;
 };
 
 USTRUCT(BlueprintType)
@@ -102,6 +265,10 @@ struct FActorPopData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Pop Data")
 	float OptionalMagnitude;
 
+	/* Variant pool to take the actor from, actors in it are already set up as the variant */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool Pop Data")
+	FActorPoolVariant PoolVariant;
+
 	virtual APawn* GetInstigator() const
 	{
 		return Instigator;
@@ -123,6 +290,14 @@ struct FActorPopData
 	}
 };
 
+/* How pool callbacks are dispatched for a class, resolved once per class so C++ implementations can skip Blueprint event dispatch */
+struct FPooledActorCallbackDispatch
+{
+	bool bNativeOnPoolEntered = false;
+
+	bool bNativeOnPoolLeft = false;
+};
+
 USTRUCT(BlueprintType)
 struct FActorPool
 {
@@ -140,11 +315,6 @@ struct FActorPool
 		MaximumPoolSize = InMaximumPoolSize;
 	}
 
-	virtual ~FActorPool()
-	{
-		UE_LOG(LogTemp, Display, TEXT("Actor Pool is being destroyed"));
-	}
-
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Pool")
 	TArray<AActor*> Pool;
@@ -170,3 +340,19 @@ struct FActorPool
 	bool ContainsActor(AActor* Actor) const;
 
 };
+
+/* Pool handed over to the game instance during seamless travel so it can be adopted by the next world */
+USTRUCT(BlueprintType)
+struct FPersistentActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Persistent Actor Pool")
+	TSubclassOf<AActor> ActorClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Persistent Actor Pool")
+	FActorPoolVariant Variant;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Persistent Actor Pool")
+	FActorPool ActorPool;
+};
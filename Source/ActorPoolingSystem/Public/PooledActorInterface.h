@@ -15,7 +15,8 @@ class UPooledActorInterface : public UInterface
 };
 
 /**
- * 
+ * C++ classes that implement the _Implementation functions and aren't overridden in Blueprint
+ * have them called directly by the actor pool world subsystem instead of going through Blueprint event dispatch
  */
 class ACTORPOOLINGSYSTEM_API IPooledActorInterface
 {
@@ -29,4 +30,8 @@ public:
 
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Pool Actor", meta = (DisplayName = "On Pool Left"))
 	void OnPoolLeft(const FActorPopData& PopData);
+
+	/* Called once after the actor is spawned into a variant pool, set up the variant here so it doesn't have to be done every time the actor leaves the pool */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Pool Actor", meta = (DisplayName = "On Pool Variant Assigned"))
+	void OnPoolVariantAssigned(const FActorPoolVariant& Variant);
 };